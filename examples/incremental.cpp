@@ -0,0 +1,62 @@
+#include <CliLib.hpp>
+#include <iostream>
+
+//? prints the command line after a change together with its diagnostics, like an editor would underline them
+void show(const IncrementalParser& parser, const std::vector<std::string>& args) {
+    std::cout << "$ tool";
+    for (const auto& arg : args)
+        std::cout << " " << arg;
+    std::cout << "\n";
+
+    if (parser.getDiagnostics().empty())
+        std::cout << "  ok (depth " << parser.getDepth() << ")\n";
+
+    for (const auto& diagnostic : parser.getDiagnostics())
+        std::cout << "  \"" << diagnostic.token << "\": " << diagnostic.message << "\n";
+}
+
+int main() {
+    //? the tree is only validated here, so the functions are never called
+    Command defaultCommand("The default command", [](){});
+
+    Command commit("Commits the staged changes", [](){});
+    OptionGroup commitReq("Required options");
+    commitReq.addOption(new FlagOption("-m", "The commit message itself", "--message"));
+    commit.addOptionGroup(&commitReq);
+
+    Command push("Pushes the commits", [](){});
+    OptionGroup pushReq("Required options");
+    pushReq.addOption(new PositionalOption(0, "The branch to push to"));
+    push.addOptionGroup(&pushReq);
+
+    defaultCommand.addSubCommand(&commit, "commit");
+    defaultCommand.addSubCommand(&push, "push");
+
+    IncrementalParser parser(&defaultCommand);
+    std::vector<std::string> args;
+
+    //? typing "commit -m fix" one argument at a time
+    for (const std::string arg : {"commit", "-m", "fix"}) {
+        parser.insert(args.size(), arg);
+        args.emplace_back(arg);
+        show(parser, args);
+    }
+
+    //? a typo in the flag, then its correction
+    parser.edit(1, "-x");
+    args[1] = "-x";
+    show(parser, args);
+
+    parser.edit(1, "--message");
+    args[1] = "--message";
+    show(parser, args);
+
+    //? replacing the subcommand revalidates the remaining arguments against push
+    parser.edit(0, "push");
+    args[0] = "push";
+    show(parser, args);
+
+    parser.erase(1);
+    args.erase(args.begin() + 1);
+    show(parser, args);
+}
@@ -0,0 +1,52 @@
+#include <CliLib.hpp>
+#include <iostream>
+#include <algorithm>
+
+//? in a pipeline every segment has its own tokens, so options are read inside the command functions
+//? (the subcommand names are already consumed there, so the indent is 0)
+//? an option without a value fails only its own segment
+void fetchFunc() {
+    std::string remote = Parser::getConverted<std::string>("-r", "--remote", "origin");
+    std::cout << "Fetched from " << remote << "\n";
+}
+
+void buildFunc() {
+    std::string target = Parser::getConverted<std::string>(0);
+    std::cout << "Built target " << target << "\n";
+}
+
+void testFunc() {
+    int jobs = Parser::getConverted<int>("-j", "--jobs", 1);
+    std::cout << "Ran " << jobs << " test job(s)\n";
+}
+
+int main(int argc, char** argv) {
+    Parser::parse(argc, argv);
+
+    Command defaultCommand("Runs several commands separated by -- (in order) or ++ (concurrently)", [&](){defaultCommand.printHelp("Usage");});
+
+    Command fetch("Fetches the sources", fetchFunc);
+    OptionGroup fetchOpt("Optional options", FlagPolicy::OPTIONAL);
+    fetchOpt.addOption(new FlagOption("-r", "The remote to fetch from", "--remote"));
+    fetch.addOptionGroup(&fetchOpt);
+
+    Command build("Builds a target", buildFunc);
+    OptionGroup buildReq("Required options");
+    buildReq.addOption(new PositionalOption(0, "The target to build"));
+    build.addOptionGroup(&buildReq);
+
+    Command test("Runs the tests", testFunc);
+    OptionGroup testOpt("Optional options", FlagPolicy::OPTIONAL);
+    testOpt.addOption(new FlagOption("-j", "The number of test jobs", "--jobs"));
+    test.addOptionGroup(&testOpt);
+
+    defaultCommand.addSubCommand(&fetch, "fetch");
+    defaultCommand.addSubCommand(&build, "build");
+    defaultCommand.addSubCommand(&test, "test");
+
+    //? Ex.: pipeline fetch -r upstream -- build lib ++ build app -- test -j 4
+    std::vector<RunStatus> results = defaultCommand.runPipeline();
+
+    //? segments after a help request are SKIPPED, so only invalid segments count as failures
+    return std::none_of(results.begin(), results.end(), [](RunStatus status) { return status == RunStatus::INVALID_COMMAND || status == RunStatus::INVALID_OPTIONS; }) ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include <CliLib.hpp>
+#include <iostream>
+
+//? bump this whenever the command definitions below change, a snapshot with another version is ignored and rewritten
+const uint32_t cliVersion = 1;
+const std::string schemaPath = "calc.schema";
+
+//? the options are read inside the functions (with indent 0), so the same functions work with and without the tree
+void addFunc() {
+    std::vector<int> numbers = Parser::getMultiConverted<int>(0);
+
+    int sum = 0;
+    for (int number : numbers)
+        sum += number;
+    std::cout << sum << "\n";
+}
+
+void negateFunc() {
+    int number = Parser::getConverted<int>(0);
+    bool twice = Parser::getConverted<bool>("-t", "--twice", false);
+    std::cout << (twice ? number : -number) << "\n";
+}
+
+int main(int argc, char** argv) {
+    Parser::parse(argc, argv);
+
+    //? fast path: the snapshot checks the arguments and only the selected function runs, the tree is never built
+    CommandSchema schema;
+    if (schema.load(schemaPath, cliVersion)) {
+        std::map<std::string, std::function<void()>> functions = {
+                {"", [&schema](){schema.printHelp(0, "Usage");}},
+                {"add", addFunc},
+                {"negate", negateFunc}
+        };
+
+        if (schema.dispatch(functions) != RunStatus::UNREGISTERED)
+            return 0;
+    }
+
+    //? fallback: build the tree, write a fresh snapshot for the next run and run as usual
+    Command defaultCommand("A small calculator that starts from a schema snapshot when it can", [&](){defaultCommand.printHelp("Usage");});
+
+    Command add("Adds numbers", addFunc);
+    OptionGroup addReq("Required options");
+    addReq.addOption(new PositionalOption(0, "The numbers to add"));
+    add.addOptionGroup(&addReq);
+
+    Command negate("Negates a number", negateFunc);
+    OptionGroup negateReq("Required options");
+    negateReq.addOption(new PositionalOption(0, "The number to negate"));
+    OptionGroup negateOpt("Optional options", FlagPolicy::OPTIONAL);
+    negateOpt.addOption(new FlagOption("-t", "Negate it twice", "--twice"));
+    negate.addOptionGroup(&negateReq, &negateOpt);
+
+    defaultCommand.addSubCommand(&add, "add", "plus");
+    defaultCommand.addSubCommand(&negate, "negate", "neg");
+
+    if (!schema.isLoaded())
+        CommandSchema::save(defaultCommand, schemaPath, cliVersion);
+
+    defaultCommand.run();
+}
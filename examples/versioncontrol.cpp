@@ -5,10 +5,13 @@ void commitFunc(const std::string& messsage) {
     std::cout << "Commited " << "with message: " << messsage << "\n";
 }
 
-void stageFunc(const std::vector<std::string>& toStage) {
+//? "stage -" reads the items from stdin, the subcommand name is already consumed here so the indent is 0
+void stageFunc() {
     std::cout << "Staged: ";
-    for (const auto& element : toStage)
-        std::cout << element << " ";
+    Parser::streamMultiConverted<std::string>(0, 0, [](const std::vector<std::string>& toStage) {
+        for (const auto& element : toStage)
+            std::cout << element << " ";
+    });
     std::cout << "\n";
 }
 
@@ -28,6 +31,8 @@ void removeCommitFunc(int number) {
 }
 
 int main(int argc, char** argv) {
+    //? lets std::cin buffer ahead, so "stage -" receives full batches instead of one line at a time
+    std::ios::sync_with_stdio(false);
     Parser::parse(argc, argv);
 
     Command defaultCommand("The default command", [&](){defaultCommand.printHelp("Usage");});
@@ -42,13 +47,11 @@ int main(int argc, char** argv) {
 
     commit.addOptionGroup(&commitReq);
 
-    //args
-    std::vector<std::string> toStage = Parser::getMultiConverted<std::string>(0, 1);
     //command
-    Command stage("Allows you to stage changes for commiting", stageFunc, toStage);
+    Command stage("Allows you to stage changes for commiting", stageFunc);
     //options
     OptionGroup stageReq("Required options");
-    stageReq.addOption( new PositionalOption(0, "The items to stage"));
+    stageReq.addOption( new PositionalOption(0, "The items to stage", true));
 
     stage.addOptionGroup(&stageReq);
 
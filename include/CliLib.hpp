@@ -4,6 +4,22 @@
 #include <regex>
 #include <iostream>
 #include <utility>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <exception>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 enum class FlagPolicy {
     REQUIRED,
@@ -17,6 +33,21 @@ enum class PositionalPolicy {
     OPTIONAL
 };
 
+enum class RunStatus {
+    OK,
+    HELP,
+    INVALID_COMMAND,
+    INVALID_OPTIONS,
+    SKIPPED,
+    UNREGISTERED
+};
+
+//? thrown instead of exiting when an option has no value while a pipeline segment is dispatched
+class ParserError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 struct FlagOption {
     FlagOption(std::string opt, std::string desc, std::string longOption = "");
 
@@ -26,10 +57,12 @@ struct FlagOption {
 };
 
 struct PositionalOption {
-    PositionalOption(const unsigned int& pos, std::string desc);
+    PositionalOption(const unsigned int& pos, std::string desc, bool acceptsStdin = false);
 
     unsigned int pos;
     std::string desc;
+    //? the values can be streamed from stdin with a "-" or "--stdin" token (see Parser::streamMultiConverted)
+    bool acceptsStdin;
 };
 
 class OptionGroup {
@@ -56,6 +89,38 @@ public:
     std::string groupDescription;
 };
 
+//? policy checks and help formatting shared by Command and CommandSchema
+//? they work on a view of a single command (see Command::View and CommandSchema::View)
+class CommandRules {
+public:
+    struct FlagView {
+        const char* opt;
+        const char* desc;
+        const char* longOption;
+    };
+
+    struct PositionalView {
+        unsigned int pos;
+        const char* desc;
+        bool acceptsStdin;
+    };
+
+    template<typename View>
+    static bool isOption(const View& view, const std::string& str);
+    template<typename View>
+    static bool isUnknownOption(const View& view, const std::string& str);
+    template<typename View>
+    static bool hasFirstPositional(const View& view);
+    template<typename View>
+    static bool acceptsStdin(const View& view);
+    template<typename View, typename Itr, typename IsSet>
+    static bool validateOptions(const View& view, Itr first, Itr last, const IsSet& isSet);
+    template<typename View, typename IsSet>
+    static bool checkPolicies(const View& view, const IsSet& isSet, const size_t& tokenCount);
+    template<typename View>
+    static void printHelp(const View& view, const std::string& title);
+};
+
 class Command {
 public:
     template<typename Func, typename... Args>
@@ -70,12 +135,18 @@ public:
     void setHelpCommand(const std::string& shortOption, const std::string& longOption = "");
 
     void run();
+    RunStatus dispatch();
+    RunStatus dispatch(std::vector<std::string>& tokens);
+    std::vector<RunStatus> runPipeline(const std::string& separator = "--", const std::string& parallelSeparator = "++", unsigned int threadCount = 0);
 
     bool validateOptions() const;
     void printHelp(const std::string& title = "") const;
     const std::string &getDescription() const;
 
 private:
+    friend class CommandSchema;
+    friend class IncrementalParser;
+
     std::map<std::vector<std::string>, Command*> subCommands;
     std::vector<OptionGroup*> optionGroups;
     std::function<void()> commandFunction;
@@ -83,12 +154,28 @@ private:
     std::string description;
     bool noRemainder = true;
 
-    bool isOption(const std::string& str) const;
+    struct View {
+        const Command& command;
+
+        const char* description() const;
+        bool noRemainder() const;
+        size_t groupCount() const;
+        const char* groupDescription(const size_t& group) const;
+        FlagPolicy flagPolicy(const size_t& group) const;
+        PositionalPolicy positionalPolicy(const size_t& group) const;
+        size_t flagCount(const size_t& group) const;
+        CommandRules::FlagView flag(const size_t& group, const size_t& option) const;
+        size_t positionalCount(const size_t& group) const;
+        CommandRules::PositionalView positional(const size_t& group, const size_t& option) const;
+        template<typename Func>
+        void forEachSubCommand(Func func) const;
+    };
 };
 
 class Parser {
 public:
     static void parse (const int& argc, char const*const* argv, bool splitFlags = false);
+    static void tokenize (const std::string& arg, bool splitFlags, std::vector<std::string>& out);
 
     //FlagOption
     template<typename T>
@@ -101,18 +188,174 @@ public:
     static T getConverted(const unsigned int& pos, const unsigned int& indent = 0, const T& defaultValue = T());
     template<typename T>
     static std::vector<T> getMultiConverted(const unsigned int& pos, const unsigned int& indent = 0, std::initializer_list<T> defaultInit = {});
+    //? a "-" or "--stdin" token is replaced by the lines of input, values are passed to callback in batches of at most batchSize
+    //? the positional option has to be constructed with acceptsStdin, otherwise "--stdin" is an unrecognized option
+    //? a partial batch is delivered whenever the next line is not available yet, so slow producers are not held back
+    template<typename T, typename Func>
+    static size_t streamMultiConverted(const unsigned int& pos, const unsigned int& indent, Func callback, const size_t& batchSize = 64, std::istream& input = std::cin);
 
     static bool isSet(const std::string &option);
     static bool hasOptionSyntax(const std::string& str);
+    static bool isStdinMarker(const std::string& str);
+
+    //? the tokens of the pipeline segment being dispatched on this thread, Parser::tokens otherwise
+    static std::vector<std::string>& activeTokens();
 
     static std::vector<std::string> tokens;
 private:
+    friend class Command;
+
+    static thread_local std::vector<std::string>* segmentTokens;
+    //? concurrent pipeline segments share one input, a marker reads it to the end before the next one can start
+    static std::mutex inputMutex;
+
+    [[noreturn]] static void fail(const std::string& message);
 
     static std::string getFlagRaw (const std::string& option, const std::string& longOption = "");
     static std::vector<std::string> getMultiFlagRaw(const std::string& option, const std::string& longOption = "");
 
     static std::string getPositionalRaw (const unsigned int& pos, const unsigned int& indent);
     static std::vector<std::string> getMultiPositionalRaw (const unsigned int& pos, const unsigned int& indent);
+
+    template<typename T>
+    static T convert(const std::string& rawValue);
+};
+
+//? read-only binary snapshot of a command tree (descriptions, names, groups, options and policies)
+//? a snapshot with a different format version, user version or checksum is rejected by load()
+//? the checksum only catches corrupted files, whether the snapshot still matches the command definitions is decided by the user version alone
+//? so the user version has to change whenever the definitions do, otherwise an outdated snapshot is loaded
+class CommandSchema {
+public:
+    CommandSchema() = default;
+    CommandSchema(const CommandSchema&) = delete;
+    CommandSchema& operator=(const CommandSchema&) = delete;
+    ~CommandSchema();
+
+    static bool save(const Command& root, const std::string& path, const uint32_t& userVersion);
+    bool load(const std::string& path, const uint32_t& userVersion);
+    bool isLoaded() const;
+
+    //? node 0 is the root command, depth is the number of tokens that were subcommand names
+    unsigned int resolve(unsigned int& depth) const;
+    bool isValidCommand(const unsigned int& node, const unsigned int& depth) const;
+    bool isHelpRequested(const unsigned int& node, const unsigned int& depth) const;
+    bool validateOptions(const unsigned int& node, const unsigned int& depth) const;
+    void printHelp(const unsigned int& node, const std::string& title = "") const;
+    const char* getDescription(const unsigned int& node) const;
+    //? the stable identity of a node: the first name of every subcommand on the way from the root, separated by spaces ("" for the root, Ex.: "remove commit")
+    const char* getPath(const unsigned int& node) const;
+
+    //? checks and runs the selected command without building the tree, functions are keyed by getPath() of their command
+    //? returns UNREGISTERED and leaves the tokens untouched if the selected command has no function (build the tree and run it then)
+    RunStatus dispatch(const std::map<std::string, std::function<void()>>& functions) const;
+
+    static const uint32_t formatVersion = 3;
+
+private:
+    struct Header { char magic[4]; uint32_t formatVersion; uint32_t userVersion; uint32_t payloadSize; uint32_t checksum; };
+    struct Counts { uint32_t nodes, links, names, groups, flags, positionals, stringBytes; };
+    struct NodeRecord { uint32_t path, description, helpShort, helpLong, noRemainder, firstGroup, groupCount, firstLink, linkCount; };
+    struct LinkRecord { uint32_t child, firstName, nameCount; };
+    struct GroupRecord { uint32_t description, flagPolicy, positionalPolicy, firstFlag, flagCount, firstPositional, positionalCount; };
+    struct FlagRecord { uint32_t opt, desc, longOption; };
+    struct PositionalRecord { uint32_t pos, desc, acceptsStdin; };
+
+    const char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<char> buffer;
+
+    const Counts* counts = nullptr;
+    const NodeRecord* nodes = nullptr;
+    const LinkRecord* links = nullptr;
+    const uint32_t* names = nullptr;
+    const GroupRecord* groups = nullptr;
+    const FlagRecord* flags = nullptr;
+    const PositionalRecord* positionals = nullptr;
+    const char* strings = nullptr;
+
+    void release();
+    bool bind(const uint32_t& userVersion);
+    bool isSet(const std::string& option, const unsigned int& depth) const;
+    const char* str(const uint32_t& offset) const;
+
+    static uint32_t checksum(const char* bytes, size_t length);
+
+    struct View {
+        const CommandSchema& schema;
+        const NodeRecord& node;
+
+        const char* description() const;
+        bool noRemainder() const;
+        size_t groupCount() const;
+        const char* groupDescription(const size_t& group) const;
+        FlagPolicy flagPolicy(const size_t& group) const;
+        PositionalPolicy positionalPolicy(const size_t& group) const;
+        size_t flagCount(const size_t& group) const;
+        CommandRules::FlagView flag(const size_t& group, const size_t& option) const;
+        size_t positionalCount(const size_t& group) const;
+        CommandRules::PositionalView positional(const size_t& group, const size_t& option) const;
+        template<typename Func>
+        void forEachSubCommand(Func func) const;
+    };
+};
+
+//? keeps the tokens, the subcommand path and the validation state of an argument list that is edited one word at a time
+//? only the edited word (and the path, if the edit touches it) is reprocessed
+//? like Command::dispatch the path is walked by token, so "rm=commit" selects both subcommands
+class IncrementalParser {
+public:
+    struct Diagnostic {
+        std::string token;
+        std::string message;
+    };
+
+    explicit IncrementalParser(const Command* root, bool splitFlags = false);
+
+    const std::vector<Diagnostic>& insert(const size_t& index, const std::string& arg);
+    const std::vector<Diagnostic>& erase(const size_t& index);
+    const std::vector<Diagnostic>& edit(const size_t& index, const std::string& arg);
+
+    const std::vector<Diagnostic>& getDiagnostics() const;
+    const Command* getCommand() const;
+    size_t getDepth() const;
+    size_t size() const;
+
+private:
+    struct Word {
+        std::string arg;
+        std::vector<std::string> tokens;
+    };
+
+    struct Position {
+        size_t word;
+        size_t token;
+    };
+
+    bool splitFlags;
+    std::vector<Word> words;
+    //? path[i + 1] was selected by the token at pathPositions[i]
+    std::vector<const Command*> path;
+    std::vector<Position> pathPositions;
+    bool pathChanged = false;
+
+    //? token -> count for the tokens after the subcommand path
+    std::map<std::string, unsigned int> tokenIndex;
+    std::map<std::string, unsigned int> flagIndex;
+    std::map<std::string, unsigned int> unknownOptions;
+    size_t tokenCount = 0;
+
+    std::vector<Diagnostic> diagnostics;
+
+    Word makeWord(const std::string& arg) const;
+    void index(const Word& word, const int& delta);
+    void index(const std::string& token, const int& delta);
+    Position next() const;
+    static void count(std::map<std::string, unsigned int>& counts, const std::string& token, const int& delta);
+    void unwind(const size_t& index);
+    void extend();
+    const std::vector<Diagnostic>& update();
 };
 
 //FlagOption
@@ -121,7 +364,7 @@ FlagOption::FlagOption(std::string opt, std::string desc, std::string longOption
 
 //PositionalOption
 
-PositionalOption::PositionalOption(const unsigned int& pos, std::string desc) : pos(pos), desc(std::move(desc)) { }
+PositionalOption::PositionalOption(const unsigned int& pos, std::string desc, bool acceptsStdin) : pos(pos), desc(std::move(desc)), acceptsStdin(acceptsStdin) { }
 
 //OptionGroup
 OptionGroup::OptionGroup(std::string description, FlagPolicy fp, PositionalPolicy pp) : groupDescription(std::move(description)), flagPolicy(fp), positionalPolicy(pp) {}
@@ -184,72 +427,278 @@ void Command::setHelpCommand(const std::string& shortOption, const std::string&
 }
 
 void Command::run() {
-    if (!Parser::tokens.empty()) {
+    if (dispatch() != RunStatus::OK)
+        exit(0);
+}
+
+RunStatus Command::dispatch() {
+    std::vector<std::string>& tokens = Parser::activeTokens();
+
+    if (!tokens.empty()) {
         for (const auto& command : subCommands)
             for (const auto& name : command.first)
-                if (Parser::tokens[0] == name) {
-                    Parser::tokens.erase(Parser::tokens.begin());
-                    command.second->run();
-                    return;
+                if (tokens[0] == name) {
+                    tokens.erase(tokens.begin());
+                    return command.second->dispatch();
                 }
 
-        bool hasFirstPositional = false;
-        for (const auto& group : optionGroups)
-            for (const auto& positionalOption : group->positionalOptions)
-                if (positionalOption->pos == 0)
-                    hasFirstPositional = true;
-
-        if (!Parser::hasOptionSyntax(Parser::tokens[0]) && !hasFirstPositional) {
-            std::cerr << "\"" << Parser::tokens[0] << "\" is not a valid command\n";
-            exit(0);
+        if (!Parser::hasOptionSyntax(tokens[0]) && !CommandRules::hasFirstPositional(View{*this})) {
+            std::cerr << "\"" << tokens[0] << "\" is not a valid command\n";
+            return RunStatus::INVALID_COMMAND;
         }
     }
 
     if (Parser::isSet(helpCommand.first) || Parser::isSet(helpCommand.second)) {
         printHelp("Command usage");
-        exit(0);
+        return RunStatus::HELP;
     }
 
     if (!validateOptions()) {
         std::cerr << "No/Invalid parameters provided (Use --help for more information)\n";
-        exit(0);
+        return RunStatus::INVALID_OPTIONS;
     }
 
     commandFunction();
+    return RunStatus::OK;
+}
+
+//? runs with tokens as the token view of this thread, used for the segments of a pipeline
+//? an option without a value fails the segment with INVALID_OPTIONS instead of exiting
+RunStatus Command::dispatch(std::vector<std::string>& tokens) {
+    std::vector<std::string>* previous = Parser::segmentTokens;
+    Parser::segmentTokens = &tokens;
+
+    RunStatus status;
+    try {
+        status = dispatch();
+    } catch (const ParserError&) {
+        status = RunStatus::INVALID_OPTIONS;
+    } catch (...) {
+        Parser::segmentTokens = previous;
+        throw;
+    }
+
+    Parser::segmentTokens = previous;
+    return status;
+}
+
+std::vector<RunStatus> Command::runPipeline(const std::string& separator, const std::string& parallelSeparator, unsigned int threadCount) {
+    //? stages run one after another, the segments of a stage run concurrently
+    std::vector<std::vector<std::vector<std::string>>> stages(1, std::vector<std::vector<std::string>>(1));
+    for (const auto& token : Parser::activeTokens()) {
+        if (token == separator)
+            stages.emplace_back(1);
+        else if (token == parallelSeparator)
+            stages.back().emplace_back();
+        else
+            stages.back().back().emplace_back(token);
+    }
+
+    //? empty segments and stages are dropped, only an empty argv runs the default command (as "tool" does without a pipeline)
+    for (auto& stage : stages)
+        stage.erase(std::remove_if(stage.begin(), stage.end(), [](const std::vector<std::string>& segment) { return segment.empty(); }), stage.end());
+    stages.erase(std::remove_if(stages.begin(), stages.end(), [](const std::vector<std::vector<std::string>>& stage) { return stage.empty(); }), stages.end());
+
+    if (stages.empty() && Parser::activeTokens().empty())
+        stages.emplace_back(1);
+
+    std::vector<RunStatus> results;
+    bool stopped = false;
+
+    for (auto& stage : stages) {
+        size_t first = results.size();
+        results.resize(first + stage.size(), RunStatus::SKIPPED);
+
+        if (stopped)
+            continue;
+
+        if (stage.size() == 1) {
+            results[first] = dispatch(stage[0]);
+        } else {
+            unsigned int workerCount = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+            workerCount = std::max(1u, std::min(workerCount, static_cast<unsigned int>(stage.size())));
+
+            //? an exception escaping a thread would call std::terminate, so the first one is kept and rethrown after the join
+            std::atomic<size_t> next(0);
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            std::vector<std::thread> workers;
+            for (unsigned int i = 0; i < workerCount; ++i)
+                workers.emplace_back([this, &stage, &results, &next, &error, &errorMutex, first]() {
+                    for (size_t segment = next++; segment < stage.size(); segment = next++) {
+                        try {
+                            results[first + segment] = dispatch(stage[segment]);
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(errorMutex);
+                            if (!error)
+                                error = std::current_exception();
+                            next = stage.size();
+                        }
+                    }
+                });
+
+            for (auto& worker : workers)
+                worker.join();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        //? like run(), which exits after printing help, a help request also ends the pipeline
+        for (size_t i = first; i < results.size(); ++i)
+            if (results[i] != RunStatus::OK)
+                stopped = true;
+    }
+
+    return results;
 }
 
 bool Command::validateOptions() const {
-    if (noRemainder)
-        for (const std::string& token : Parser::tokens)
-            if (Parser::hasOptionSyntax(token) && !isOption(token))
+    const std::vector<std::string>& tokens = Parser::activeTokens();
+    return CommandRules::validateOptions(View{*this}, tokens.begin(), tokens.end(), Parser::isSet);
+}
+
+void Command::printHelp(const std::string &title) const {
+    CommandRules::printHelp(View{*this}, title);
+}
+
+const std::string &Command::getDescription() const {
+    return description;
+}
+
+const char* Command::View::description() const {
+    return command.description.c_str();
+}
+
+bool Command::View::noRemainder() const {
+    return command.noRemainder;
+}
+
+size_t Command::View::groupCount() const {
+    return command.optionGroups.size();
+}
+
+const char* Command::View::groupDescription(const size_t& group) const {
+    return command.optionGroups[group]->groupDescription.c_str();
+}
+
+FlagPolicy Command::View::flagPolicy(const size_t& group) const {
+    return command.optionGroups[group]->flagPolicy;
+}
+
+PositionalPolicy Command::View::positionalPolicy(const size_t& group) const {
+    return command.optionGroups[group]->positionalPolicy;
+}
+
+size_t Command::View::flagCount(const size_t& group) const {
+    return command.optionGroups[group]->flagOptions.size();
+}
+
+CommandRules::FlagView Command::View::flag(const size_t& group, const size_t& option) const {
+    const FlagOption* flagOption = command.optionGroups[group]->flagOptions[option];
+    return {flagOption->opt.c_str(), flagOption->desc.c_str(), flagOption->longOption.c_str()};
+}
+
+size_t Command::View::positionalCount(const size_t& group) const {
+    return command.optionGroups[group]->positionalOptions.size();
+}
+
+CommandRules::PositionalView Command::View::positional(const size_t& group, const size_t& option) const {
+    const PositionalOption* positionalOption = command.optionGroups[group]->positionalOptions[option];
+    return {positionalOption->pos, positionalOption->desc.c_str(), positionalOption->acceptsStdin};
+}
+
+template<typename Func>
+void Command::View::forEachSubCommand(Func func) const {
+    for (const auto& subCommand : command.subCommands) {
+        std::vector<const char*> names;
+        for (const auto& name : subCommand.first)
+            names.emplace_back(name.c_str());
+
+        func(names, subCommand.second->description.c_str());
+    }
+}
+
+//CommandRules
+template<typename View>
+bool CommandRules::isOption(const View& view, const std::string& str) {
+    for (size_t i = 0; i < view.groupCount(); ++i)
+        for (size_t j = 0; j < view.flagCount(i); ++j) {
+            FlagView option = view.flag(i, j);
+            if (str == option.opt || str == option.longOption)
+                return true;
+        }
+
+    return false;
+}
+
+template<typename View>
+bool CommandRules::isUnknownOption(const View& view, const std::string& str) {
+    return Parser::hasOptionSyntax(str) && !isOption(view, str) && !(Parser::isStdinMarker(str) && acceptsStdin(view));
+}
+
+template<typename View>
+bool CommandRules::hasFirstPositional(const View& view) {
+    for (size_t i = 0; i < view.groupCount(); ++i)
+        for (size_t j = 0; j < view.positionalCount(i); ++j)
+            if (view.positional(i, j).pos == 0)
+                return true;
+
+    return false;
+}
+
+template<typename View>
+bool CommandRules::acceptsStdin(const View& view) {
+    for (size_t i = 0; i < view.groupCount(); ++i)
+        for (size_t j = 0; j < view.positionalCount(i); ++j)
+            if (view.positional(i, j).acceptsStdin)
+                return true;
+
+    return false;
+}
+
+template<typename View, typename Itr, typename IsSet>
+bool CommandRules::validateOptions(const View& view, Itr first, Itr last, const IsSet& isSet) {
+    if (view.noRemainder())
+        for (Itr itr = first; itr != last; ++itr)
+            if (isUnknownOption(view, *itr))
                 return false;
 
+    return checkPolicies(view, isSet, static_cast<size_t>(std::distance(first, last)));
+}
+
+template<typename View, typename IsSet>
+bool CommandRules::checkPolicies(const View& view, const IsSet& isSet, const size_t& tokenCount) {
     bool valid = true;
 
-    for (const auto& group : optionGroups) {
+    for (size_t i = 0; i < view.groupCount(); ++i) {
+        FlagPolicy flagPolicy = view.flagPolicy(i);
+        PositionalPolicy positionalPolicy = view.positionalPolicy(i);
+
         bool wasOne = false;
-        for (const auto& option : group->flagOptions) {
-            valid = Parser::isSet(option->opt) || Parser::isSet(option->longOption);
+        for (size_t j = 0; j < view.flagCount(i); ++j) {
+            FlagView option = view.flag(i, j);
+            valid = isSet(option.opt) || isSet(option.longOption);
 
-            if ((group->flagPolicy == FlagPolicy::REQUIRED && !valid) || (group->flagPolicy == FlagPolicy::ANYOF && valid))
+            if ((flagPolicy == FlagPolicy::REQUIRED && !valid) || (flagPolicy == FlagPolicy::ANYOF && valid))
                 break;
-            else if (group->flagPolicy == FlagPolicy::ONEOF && valid && !wasOne)
+            else if (flagPolicy == FlagPolicy::ONEOF && valid && !wasOne)
                 wasOne = true;
-            else if (group->flagPolicy == FlagPolicy::ONEOF && valid && wasOne) {
+            else if (flagPolicy == FlagPolicy::ONEOF && valid && wasOne) {
                 valid = false;
                 break;
-            } else if ((group->flagPolicy == FlagPolicy::OPTIONAL) || (group->flagPolicy == FlagPolicy::ONEOF && !valid && wasOne))
+            } else if ((flagPolicy == FlagPolicy::OPTIONAL) || (flagPolicy == FlagPolicy::ONEOF && !valid && wasOne))
                 valid = true;
         }
         if (!valid)
             break;
 
-        for (const auto& positionalOption : group->positionalOptions) {
-            valid = (positionalOption->pos < Parser::tokens.size());
+        for (size_t j = 0; j < view.positionalCount(i); ++j) {
+            valid = (view.positional(i, j).pos < tokenCount);
 
-            if (group->positionalPolicy == PositionalPolicy::REQUIRED && !valid)
+            if (positionalPolicy == PositionalPolicy::REQUIRED && !valid)
                 break;
-            else if (group->positionalPolicy == PositionalPolicy::OPTIONAL)
+            else if (positionalPolicy == PositionalPolicy::OPTIONAL)
                 valid = true;
         }
         if (!valid)
@@ -259,84 +708,664 @@ bool Command::validateOptions() const {
     return valid;
 }
 
-void Command::printHelp(const std::string &title) const {
-    if (!title.empty()) {
+template<typename View>
+void CommandRules::printHelp(const View& view, const std::string& title) {
+    if (!title.empty())
+        std::cout << std::string(title.size(), '-') << "\n" << title << "\n" << std::string(title.size(), '-') << "\n";
+
+    std::cout << "Command description: " << view.description() << "\n\n";
+
+    bool hasSubCommands = false;
+    view.forEachSubCommand([&hasSubCommands](const std::vector<const char*>& names, const char* description) {
+        if (!hasSubCommands)
+            std::cout << "Subcommands: (Use --help on the subcommand for more information)\n";
+        hasSubCommands = true;
 
-        for (char i : title)
-            std::cout << "-";
-        std::cout << "\n" << title << "\n";
-        for (char i : title)
-            std::cout << "-";
+        std::cout << "\t";
+        for (size_t i = 0; i < names.size(); ++i)
+            std::cout << names[i] << (i + 1 != names.size() ? ", " : "");
 
+        std::cout << " - " << description << "\n";
+    });
+
+    if (hasSubCommands)
         std::cout << "\n";
+
+    if (view.groupCount() != 0) {
+        std::string policyNames[] = {"REQUIRED", "OPTIONAL", "ANYOF", "ONEOF"};
+
+        std::cout << "Options:";
+
+        for (size_t i = 0; i < view.groupCount(); ++i) {
+            std::cout << "\n[" << view.groupDescription(i) << "] | (Flag Policy: " << policyNames[static_cast<int>(view.flagPolicy(i))] << ") (Positional Policy: " << policyNames[static_cast<int>(view.positionalPolicy(i))] << ")\n";
+
+            for (size_t j = 0; j < view.flagCount(i); ++j) {
+                FlagView option = view.flag(i, j);
+                std::cout << "\t" << option.opt << (*option.longOption == '\0' ? "" : ", " + std::string(option.longOption)) << " - " << option.desc << std::endl;
+            }
+
+            for (size_t j = 0; j < view.positionalCount(i); ++j) {
+                PositionalView positionalOption = view.positional(i, j);
+                std::cout << "\tPosition: " << positionalOption.pos << " - " << positionalOption.desc << (positionalOption.acceptsStdin ? " (- or --stdin reads them from stdin)" : "") << std::endl;
+            }
+        }
     }
+}
 
-    std::cout << "Command description: " << description << "\n\n";
+//CommandSchema
+CommandSchema::~CommandSchema() {
+    release();
+}
 
-    if (!subCommands.empty()) {
-        std::cout << "Subcommands: (Use --help on the subcommand for more information)\n";
+bool CommandSchema::save(const Command& root, const std::string& path, const uint32_t& userVersion) {
+    std::vector<const Command*> order = {&root};
+    std::vector<std::string> paths = {""};
+    std::map<const Command*, uint32_t> indices = {{&root, 0}};
+
+    std::vector<NodeRecord> nodeRecords;
+    std::vector<LinkRecord> linkRecords;
+    std::vector<uint32_t> nameRecords;
+    std::vector<GroupRecord> groupRecords;
+    std::vector<FlagRecord> flagRecords;
+    std::vector<PositionalRecord> positionalRecords;
+
+    std::string stringBlob;
+    std::map<std::string, uint32_t> stringOffsets;
+    auto intern = [&](const std::string& value) -> uint32_t {
+        auto itr = stringOffsets.find(value);
+        if (itr != stringOffsets.end())
+            return itr->second;
+
+        auto offset = static_cast<uint32_t>(stringBlob.size());
+        stringBlob.append(value);
+        stringBlob.push_back('\0');
+        stringOffsets.emplace(value, offset);
+        return offset;
+    };
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Command* command = order[i];
+
+        NodeRecord node = {};
+        node.path = intern(paths[i]);
+        node.description = intern(command->description);
+        node.helpShort = intern(command->helpCommand.first);
+        node.helpLong = intern(command->helpCommand.second);
+        node.noRemainder = command->noRemainder ? 1 : 0;
+        node.firstGroup = static_cast<uint32_t>(groupRecords.size());
+        node.groupCount = static_cast<uint32_t>(command->optionGroups.size());
+        node.firstLink = static_cast<uint32_t>(linkRecords.size());
+        node.linkCount = static_cast<uint32_t>(command->subCommands.size());
+
+        for (const auto& group : command->optionGroups) {
+            GroupRecord groupRecord = {};
+            groupRecord.description = intern(group->groupDescription);
+            groupRecord.flagPolicy = static_cast<uint32_t>(group->flagPolicy);
+            groupRecord.positionalPolicy = static_cast<uint32_t>(group->positionalPolicy);
+            groupRecord.firstFlag = static_cast<uint32_t>(flagRecords.size());
+            groupRecord.flagCount = static_cast<uint32_t>(group->flagOptions.size());
+            groupRecord.firstPositional = static_cast<uint32_t>(positionalRecords.size());
+            groupRecord.positionalCount = static_cast<uint32_t>(group->positionalOptions.size());
 
-        for (const auto& command : subCommands) {
-            std::cout << "\t";
-            for (const auto& name : command.first)
-                std::cout << name << (name != *--command.first.end() ? ", " : "");
+            for (const auto& option : group->flagOptions)
+                flagRecords.push_back({intern(option->opt), intern(option->desc), intern(option->longOption)});
 
-            std::cout << " - " << command.second->getDescription() << "\n";
+            for (const auto& positionalOption : group->positionalOptions)
+                positionalRecords.push_back({positionalOption->pos, intern(positionalOption->desc), positionalOption->acceptsStdin ? 1u : 0u});
+
+            groupRecords.push_back(groupRecord);
         }
 
-        std::cout << "\n";
+        for (const auto& subCommand : command->subCommands) {
+            if (indices.find(subCommand.second) == indices.end()) {
+                indices.emplace(subCommand.second, static_cast<uint32_t>(order.size()));
+                order.push_back(subCommand.second);
+                const std::string name = subCommand.first.empty() ? "" : subCommand.first[0];
+                paths.push_back(paths[i].empty() ? name : paths[i] + " " + name);
+            }
+
+            linkRecords.push_back({indices[subCommand.second], static_cast<uint32_t>(nameRecords.size()), static_cast<uint32_t>(subCommand.first.size())});
+            for (const auto& name : subCommand.first)
+                nameRecords.push_back(intern(name));
+        }
+
+        nodeRecords.push_back(node);
     }
 
-    if (!optionGroups.empty()) {
-        std::string policyNames[] = {"REQUIRED", "OPTIONAL", "ANYOF", "ONEOF"};
+    Counts sectionCounts = {static_cast<uint32_t>(nodeRecords.size()), static_cast<uint32_t>(linkRecords.size()), static_cast<uint32_t>(nameRecords.size()),
+                            static_cast<uint32_t>(groupRecords.size()), static_cast<uint32_t>(flagRecords.size()), static_cast<uint32_t>(positionalRecords.size()),
+                            static_cast<uint32_t>(stringBlob.size())};
+
+    std::string payload;
+    auto append = [&payload](const void* bytes, size_t length) {
+        payload.append(static_cast<const char*>(bytes), length);
+    };
+
+    append(&sectionCounts, sizeof(Counts));
+    append(nodeRecords.data(), nodeRecords.size() * sizeof(NodeRecord));
+    append(linkRecords.data(), linkRecords.size() * sizeof(LinkRecord));
+    append(nameRecords.data(), nameRecords.size() * sizeof(uint32_t));
+    append(groupRecords.data(), groupRecords.size() * sizeof(GroupRecord));
+    append(flagRecords.data(), flagRecords.size() * sizeof(FlagRecord));
+    append(positionalRecords.data(), positionalRecords.size() * sizeof(PositionalRecord));
+    append(stringBlob.data(), stringBlob.size());
+
+    Header header = {{'C', 'L', 'I', 'S'}, formatVersion, userVersion, static_cast<uint32_t>(payload.size()), checksum(payload.data(), payload.size())};
+
+    //? other processes may have the old file mapped, so it is never rewritten in place:
+    //? the new snapshot goes to a temporary file in the same directory and replaces the old one with a rename
+#ifndef _WIN32
+    const std::string temporaryPath = path + ".tmp" + std::to_string(getpid());
+#else
+    const std::string temporaryPath = path + ".tmp";
+#endif
+
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    file.close();
+
+    if (!file) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
 
-        std::cout << "Options:";
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
 
-        for (const auto& group : optionGroups) {
-            std::cout << "\n[" << group->groupDescription << "] | (Flag Policy: " << policyNames[static_cast<int>(group->flagPolicy)] << ") (Positional Policy: " << policyNames[static_cast<int>(group->positionalPolicy)] << ")\n";
+    return true;
+}
 
-            for (const auto& option : group->flagOptions)
-                std::cout << "\t" << option->opt << (option->longOption.empty() ? "" : ", " + option->longOption) << " - " << option->desc << std::endl;
+bool CommandSchema::load(const std::string& path, const uint32_t& userVersion) {
+    release();
+
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            data = static_cast<const char*>(address);
+            size = static_cast<size_t>(fileStat.st_size);
+            mapped = true;
+        }
+    }
+    close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!buffer.empty()) {
+        data = buffer.data();
+        size = buffer.size();
+    }
+#endif
+
+    if (data == nullptr || !bind(userVersion)) {
+        release();
+        return false;
+    }
+
+    return true;
+}
+
+bool CommandSchema::isLoaded() const {
+    return counts != nullptr;
+}
+
+unsigned int CommandSchema::resolve(unsigned int& depth) const {
+    const std::vector<std::string>& tokens = Parser::activeTokens();
+
+    unsigned int node = 0;
+    depth = 0;
 
-            for (const auto& positinalOption : group->positionalOptions)
-                std::cout << "\tPosition: " << positinalOption->pos << " - " << positinalOption->desc << std::endl;
+    bool matched = true;
+    while (matched && depth < tokens.size()) {
+        matched = false;
+
+        const NodeRecord& record = nodes[node];
+        for (uint32_t i = 0; i < record.linkCount && !matched; ++i) {
+            const LinkRecord& link = links[record.firstLink + i];
+            for (uint32_t j = 0; j < link.nameCount && !matched; ++j)
+                if (tokens[depth] == str(names[link.firstName + j])) {
+                    node = link.child;
+                    ++depth;
+                    matched = true;
+                }
         }
     }
+
+    return node;
 }
 
-const std::string &Command::getDescription() const {
-    return description;
+bool CommandSchema::isValidCommand(const unsigned int& node, const unsigned int& depth) const {
+    const std::vector<std::string>& tokens = Parser::activeTokens();
+    return depth >= tokens.size() || Parser::hasOptionSyntax(tokens[depth]) || CommandRules::hasFirstPositional(View{*this, nodes[node]});
 }
 
-bool Command::isOption(const std::string &str) const {
-    for (const auto& group : optionGroups)
-        for (const auto& option : group->flagOptions)
-            if (str == option->opt || str == option->longOption)
-                return true;
+bool CommandSchema::isHelpRequested(const unsigned int& node, const unsigned int& depth) const {
+    return isSet(str(nodes[node].helpShort), depth) || isSet(str(nodes[node].helpLong), depth);
+}
 
-    return false;
+bool CommandSchema::validateOptions(const unsigned int& node, const unsigned int& depth) const {
+    const std::vector<std::string>& tokens = Parser::activeTokens();
+    return CommandRules::validateOptions(View{*this, nodes[node]}, tokens.begin() + depth, tokens.end(),
+                                         [this, depth](const std::string& option) { return isSet(option, depth); });
+}
+
+void CommandSchema::printHelp(const unsigned int& node, const std::string& title) const {
+    CommandRules::printHelp(View{*this, nodes[node]}, title);
+}
+
+const char* CommandSchema::getDescription(const unsigned int& node) const {
+    return str(nodes[node].description);
+}
+
+const char* CommandSchema::getPath(const unsigned int& node) const {
+    return str(nodes[node].path);
+}
+
+RunStatus CommandSchema::dispatch(const std::map<std::string, std::function<void()>>& functions) const {
+    if (!isLoaded())
+        return RunStatus::UNREGISTERED;
+
+    unsigned int depth;
+    unsigned int node = resolve(depth);
+
+    auto function = functions.find(getPath(node));
+    if (function == functions.end())
+        return RunStatus::UNREGISTERED;
+
+    std::vector<std::string>& tokens = Parser::activeTokens();
+
+    if (!isValidCommand(node, depth)) {
+        std::cerr << "\"" << tokens[depth] << "\" is not a valid command\n";
+        return RunStatus::INVALID_COMMAND;
+    }
+
+    if (isHelpRequested(node, depth)) {
+        printHelp(node, "Command usage");
+        return RunStatus::HELP;
+    }
+
+    if (!validateOptions(node, depth)) {
+        std::cerr << "No/Invalid parameters provided (Use --help for more information)\n";
+        return RunStatus::INVALID_OPTIONS;
+    }
+
+    //? same as Command::dispatch, the function sees the tokens without the subcommand names
+    tokens.erase(tokens.begin(), tokens.begin() + depth);
+    function->second();
+    return RunStatus::OK;
+}
+
+void CommandSchema::release() {
+#ifndef _WIN32
+    if (mapped)
+        munmap(const_cast<char*>(data), size);
+#endif
+    buffer.clear();
+
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    counts = nullptr;
+    nodes = nullptr;
+    links = nullptr;
+    names = nullptr;
+    groups = nullptr;
+    flags = nullptr;
+    positionals = nullptr;
+    strings = nullptr;
+}
+
+bool CommandSchema::bind(const uint32_t& userVersion) {
+    if (size < sizeof(Header) + sizeof(Counts))
+        return false;
+
+    Header header = {};
+    std::memcpy(&header, data, sizeof(Header));
+
+    if (std::memcmp(header.magic, "CLIS", 4) != 0 || header.formatVersion != formatVersion || header.userVersion != userVersion ||
+        header.payloadSize != size - sizeof(Header) || header.checksum != checksum(data + sizeof(Header), header.payloadSize))
+        return false;
+
+    const char* cursor = data + sizeof(Header);
+    const auto* sectionCounts = reinterpret_cast<const Counts*>(cursor);
+
+    uint64_t expectedSize = sizeof(Counts) + uint64_t(sectionCounts->nodes) * sizeof(NodeRecord) + uint64_t(sectionCounts->links) * sizeof(LinkRecord) +
+                            uint64_t(sectionCounts->names) * sizeof(uint32_t) + uint64_t(sectionCounts->groups) * sizeof(GroupRecord) +
+                            uint64_t(sectionCounts->flags) * sizeof(FlagRecord) + uint64_t(sectionCounts->positionals) * sizeof(PositionalRecord) +
+                            sectionCounts->stringBytes;
+
+    if (expectedSize != header.payloadSize || sectionCounts->nodes == 0 || sectionCounts->stringBytes == 0)
+        return false;
+
+    cursor += sizeof(Counts);
+    nodes = reinterpret_cast<const NodeRecord*>(cursor);
+    cursor += sectionCounts->nodes * sizeof(NodeRecord);
+    links = reinterpret_cast<const LinkRecord*>(cursor);
+    cursor += sectionCounts->links * sizeof(LinkRecord);
+    names = reinterpret_cast<const uint32_t*>(cursor);
+    cursor += sectionCounts->names * sizeof(uint32_t);
+    groups = reinterpret_cast<const GroupRecord*>(cursor);
+    cursor += sectionCounts->groups * sizeof(GroupRecord);
+    flags = reinterpret_cast<const FlagRecord*>(cursor);
+    cursor += sectionCounts->flags * sizeof(FlagRecord);
+    positionals = reinterpret_cast<const PositionalRecord*>(cursor);
+    cursor += sectionCounts->positionals * sizeof(PositionalRecord);
+    strings = cursor;
+
+    //? a matching checksum only proves the file is intact, indices are still checked so a hand-made file can not point outside the mapping
+    auto inRange = [](uint32_t first, uint32_t count, uint32_t total) { return uint64_t(first) + count <= total; };
+    const uint32_t stringBytes = sectionCounts->stringBytes;
+    bool consistent = strings[stringBytes - 1] == '\0';
+
+    for (uint32_t i = 0; consistent && i < sectionCounts->nodes; ++i)
+        consistent = nodes[i].path < stringBytes && nodes[i].description < stringBytes && nodes[i].helpShort < stringBytes && nodes[i].helpLong < stringBytes &&
+                     inRange(nodes[i].firstGroup, nodes[i].groupCount, sectionCounts->groups) && inRange(nodes[i].firstLink, nodes[i].linkCount, sectionCounts->links);
+
+    for (uint32_t i = 0; consistent && i < sectionCounts->links; ++i)
+        consistent = links[i].child < sectionCounts->nodes && inRange(links[i].firstName, links[i].nameCount, sectionCounts->names);
+
+    for (uint32_t i = 0; consistent && i < sectionCounts->names; ++i)
+        consistent = names[i] < stringBytes;
+
+    for (uint32_t i = 0; consistent && i < sectionCounts->groups; ++i)
+        consistent = groups[i].description < stringBytes && groups[i].flagPolicy <= static_cast<uint32_t>(FlagPolicy::ONEOF) &&
+                     groups[i].positionalPolicy <= static_cast<uint32_t>(PositionalPolicy::OPTIONAL) &&
+                     inRange(groups[i].firstFlag, groups[i].flagCount, sectionCounts->flags) && inRange(groups[i].firstPositional, groups[i].positionalCount, sectionCounts->positionals);
+
+    for (uint32_t i = 0; consistent && i < sectionCounts->flags; ++i)
+        consistent = flags[i].opt < stringBytes && flags[i].desc < stringBytes && flags[i].longOption < stringBytes;
+
+    for (uint32_t i = 0; consistent && i < sectionCounts->positionals; ++i)
+        consistent = positionals[i].desc < stringBytes && positionals[i].acceptsStdin <= 1;
+
+    if (consistent)
+        counts = sectionCounts;
+
+    return consistent;
+}
+
+bool CommandSchema::isSet(const std::string& option, const unsigned int& depth) const {
+    const std::vector<std::string>& tokens = Parser::activeTokens();
+    return std::find(tokens.begin() + depth, tokens.end(), option) != tokens.end();
+}
+
+const char* CommandSchema::str(const uint32_t& offset) const {
+    return strings + offset;
+}
+
+//? FNV-1a
+uint32_t CommandSchema::checksum(const char* bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+const char* CommandSchema::View::description() const {
+    return schema.str(node.description);
+}
+
+bool CommandSchema::View::noRemainder() const {
+    return node.noRemainder != 0;
+}
+
+size_t CommandSchema::View::groupCount() const {
+    return node.groupCount;
+}
+
+const char* CommandSchema::View::groupDescription(const size_t& group) const {
+    return schema.str(schema.groups[node.firstGroup + group].description);
+}
+
+FlagPolicy CommandSchema::View::flagPolicy(const size_t& group) const {
+    return static_cast<FlagPolicy>(schema.groups[node.firstGroup + group].flagPolicy);
+}
+
+PositionalPolicy CommandSchema::View::positionalPolicy(const size_t& group) const {
+    return static_cast<PositionalPolicy>(schema.groups[node.firstGroup + group].positionalPolicy);
+}
+
+size_t CommandSchema::View::flagCount(const size_t& group) const {
+    return schema.groups[node.firstGroup + group].flagCount;
+}
+
+CommandRules::FlagView CommandSchema::View::flag(const size_t& group, const size_t& option) const {
+    const FlagRecord& record = schema.flags[schema.groups[node.firstGroup + group].firstFlag + option];
+    return {schema.str(record.opt), schema.str(record.desc), schema.str(record.longOption)};
+}
+
+size_t CommandSchema::View::positionalCount(const size_t& group) const {
+    return schema.groups[node.firstGroup + group].positionalCount;
+}
+
+CommandRules::PositionalView CommandSchema::View::positional(const size_t& group, const size_t& option) const {
+    const PositionalRecord& record = schema.positionals[schema.groups[node.firstGroup + group].firstPositional + option];
+    return {record.pos, schema.str(record.desc), record.acceptsStdin != 0};
+}
+
+template<typename Func>
+void CommandSchema::View::forEachSubCommand(Func func) const {
+    for (uint32_t i = 0; i < node.linkCount; ++i) {
+        const LinkRecord& link = schema.links[node.firstLink + i];
+
+        std::vector<const char*> names;
+        for (uint32_t j = 0; j < link.nameCount; ++j)
+            names.emplace_back(schema.str(schema.names[link.firstName + j]));
+
+        func(names, schema.str(schema.nodes[link.child].description));
+    }
+}
+
+//IncrementalParser
+IncrementalParser::IncrementalParser(const Command* root, bool splitFlags) : splitFlags(splitFlags), path{root} {
+    update();
+}
+
+const std::vector<IncrementalParser::Diagnostic>& IncrementalParser::insert(const size_t& index, const std::string& arg) {
+    if (index > words.size())
+        return diagnostics;
+
+    unwind(index);
+    words.insert(words.begin() + index, makeWord(arg));
+    this->index(words[index], 1);
+
+    return update();
+}
+
+const std::vector<IncrementalParser::Diagnostic>& IncrementalParser::erase(const size_t& index) {
+    if (index >= words.size())
+        return diagnostics;
+
+    unwind(index);
+    this->index(words[index], -1);
+    words.erase(words.begin() + index);
+
+    return update();
+}
+
+const std::vector<IncrementalParser::Diagnostic>& IncrementalParser::edit(const size_t& index, const std::string& arg) {
+    if (index >= words.size())
+        return diagnostics;
+
+    unwind(index);
+    this->index(words[index], -1);
+    words[index] = makeWord(arg);
+    this->index(words[index], 1);
+
+    return update();
+}
+
+const std::vector<IncrementalParser::Diagnostic>& IncrementalParser::getDiagnostics() const {
+    return diagnostics;
+}
+
+const Command* IncrementalParser::getCommand() const {
+    return path.back();
+}
+
+size_t IncrementalParser::getDepth() const {
+    return path.size() - 1;
+}
+
+size_t IncrementalParser::size() const {
+    return words.size();
+}
+
+IncrementalParser::Word IncrementalParser::makeWord(const std::string& arg) const {
+    Word word;
+    word.arg = arg;
+    Parser::tokenize(arg, splitFlags, word.tokens);
+    return word;
+}
+
+void IncrementalParser::index(const Word& word, const int& delta) {
+    for (const auto& token : word.tokens)
+        index(token, delta);
+}
+
+void IncrementalParser::index(const std::string& token, const int& delta) {
+    tokenCount += delta;
+    count(tokenIndex, token, delta);
+
+    if (!Parser::hasOptionSyntax(token))
+        return;
+
+    count(flagIndex, token, delta);
+    if (CommandRules::isUnknownOption(Command::View{*getCommand()}, token))
+        count(unknownOptions, token, delta);
+}
+
+//? the position of the first token after the path
+IncrementalParser::Position IncrementalParser::next() const {
+    if (pathPositions.empty())
+        return {0, 0};
+
+    const Position& last = pathPositions.back();
+    if (last.token + 1 < words[last.word].tokens.size())
+        return {last.word, last.token + 1};
+
+    return {last.word + 1, 0};
+}
+
+void IncrementalParser::count(std::map<std::string, unsigned int>& counts, const std::string& token, const int& delta) {
+    auto itr = counts.emplace(token, 0).first;
+    itr->second += delta;
+    if (itr->second == 0)
+        counts.erase(itr);
+}
+
+//? path tokens of the words before the edited one stay on the path, the rest go back to the index and are matched again by extend()
+void IncrementalParser::unwind(const size_t& index) {
+    while (!pathPositions.empty() && pathPositions.back().word >= index) {
+        Position position = pathPositions.back();
+        pathPositions.pop_back();
+        path.pop_back();
+
+        this->index(words[position.word].tokens[position.token], 1);
+        pathChanged = true;
+    }
+}
+
+void IncrementalParser::extend() {
+    bool matched = true;
+    while (matched) {
+        matched = false;
+
+        Position position = next();
+        if (position.word >= words.size())
+            break;
+
+        const std::string& token = words[position.word].tokens[position.token];
+        for (const auto& command : getCommand()->subCommands)
+            for (const auto& name : command.first)
+                if (!matched && token == name) {
+                    index(token, -1);
+                    path.push_back(command.second);
+                    pathPositions.push_back(position);
+                    pathChanged = true;
+                    matched = true;
+                }
+    }
+}
+
+const std::vector<IncrementalParser::Diagnostic>& IncrementalParser::update() {
+    extend();
+
+    const Command* command = getCommand();
+
+    if (pathChanged) {
+        unknownOptions.clear();
+        for (const auto& flag : flagIndex)
+            if (CommandRules::isUnknownOption(Command::View{*command}, flag.first))
+                unknownOptions.emplace(flag.first, flag.second);
+
+        pathChanged = false;
+    }
+
+    diagnostics.clear();
+
+    if (tokenCount != 0) {
+        Position position = next();
+        const std::string& first = words[position.word].tokens[position.token];
+        if (!Parser::hasOptionSyntax(first) && !CommandRules::hasFirstPositional(Command::View{*command})) {
+            diagnostics.push_back({first, "\"" + first + "\" is not a valid command"});
+            return diagnostics;
+        }
+    }
+
+    auto isSet = [this](const std::string& option) { return tokenIndex.find(option) != tokenIndex.end(); };
+
+    if (isSet(command->helpCommand.first) || isSet(command->helpCommand.second))
+        return diagnostics;
+
+    if (command->noRemainder)
+        for (const auto& option : unknownOptions)
+            diagnostics.push_back({option.first, "\"" + option.first + "\" is not a valid option"});
+
+    if (!CommandRules::checkPolicies(Command::View{*command}, isSet, tokenCount))
+        diagnostics.push_back({"", "No/Invalid parameters provided"});
+
+    return diagnostics;
 }
 
 //Parser
 void Parser::parse(const int& argc, const char* const* argv, bool splitFlags) {
-    for (int i = 1; i < argc; ++i) {
-        std::string current = argv[i];
-        if (splitFlags && std::regex_match(current, std::regex("^(-[a-zA-Z]{2,})(=.*$|$)")))
-            for (int j = 1; j < current.size() && current[j - 1] != '='; ++j)
-                tokens.emplace_back((current[j] != '=') ? std::string{'-', current[j]} : current.substr(j + 1));
+    for (int i = 1; i < argc; ++i)
+        tokenize(argv[i], splitFlags, tokens);
+}
+
+void Parser::tokenize(const std::string& arg, bool splitFlags, std::vector<std::string>& out) {
+    if (splitFlags && std::regex_match(arg, std::regex("^(-[a-zA-Z]{2,})(=.*$|$)")))
+        for (int j = 1; j < arg.size() && arg[j - 1] != '='; ++j)
+            out.emplace_back((arg[j] != '=') ? std::string{'-', arg[j]} : arg.substr(j + 1));
+    else {
+        size_t equal_pos = arg.find_first_of('=');
+        if (equal_pos == std::string::npos)
+            out.emplace_back(arg);
         else {
-            size_t equal_pos = current.find_first_of('=');
-            if (equal_pos == std::string::npos)
-                tokens.emplace_back(current);
-            else {
-                tokens.emplace_back(current.substr(0, equal_pos));
-                tokens.emplace_back(current.substr(equal_pos + 1));
-            }
+            out.emplace_back(arg.substr(0, equal_pos));
+            out.emplace_back(arg.substr(equal_pos + 1));
         }
     }
 }
 
 std::string Parser::getFlagRaw(const std::string &option, const std::string &longOption) {
+    std::vector<std::string>& tokens = activeTokens();
+
     auto itr = std::find(tokens.begin(), tokens.end(), option);
     auto itrLong = std::find(tokens.begin(), tokens.end(), longOption);
 
@@ -349,10 +1378,12 @@ std::string Parser::getFlagRaw(const std::string &option, const std::string &lon
 }
 
 std::vector<std::string> Parser::getMultiFlagRaw(const std::string &option, const std::string &longOption) {
+    std::vector<std::string>& tokens = activeTokens();
+
     std::vector<std::string> values;
 
     auto itr = std::find(tokens.begin(), tokens.end(), option);
-    auto itrLong = std::find(Parser::tokens.begin(), tokens.end(), longOption);
+    auto itrLong = std::find(tokens.begin(), tokens.end(), longOption);
 
     while (itr != tokens.end() && ++itr != tokens.end() && !hasOptionSyntax(*itr))
         values.emplace_back(*itr);
@@ -364,6 +1395,8 @@ std::vector<std::string> Parser::getMultiFlagRaw(const std::string &option, cons
 }
 
 std::string Parser::getPositionalRaw(const unsigned int& pos, const unsigned int& indent) {
+    std::vector<std::string>& tokens = activeTokens();
+
     if (tokens.empty() || tokens.size() - 1 < (indent + pos))
         return "";
 
@@ -371,6 +1404,8 @@ std::string Parser::getPositionalRaw(const unsigned int& pos, const unsigned int
 }
 
 std::vector<std::string> Parser::getMultiPositionalRaw(const unsigned int& pos, const unsigned int& indent) {
+    std::vector<std::string>& tokens = activeTokens();
+
     std::vector<std::string> values;
 
     for (unsigned int i = (indent + pos); i < tokens.size(); ++i)
@@ -387,8 +1422,7 @@ T Parser::getConverted(const std::string &option, const std::string &longOption,
     if (rawValue.empty() && !(isSet(option) || isSet(longOption)))
         return defaultValue;
     else if (rawValue.empty()) {
-        std::cerr << "No value provided for \"" << option << "/" << longOption << "\"\n";
-        exit(0);
+        fail("No value provided for \"" + option + "/" + longOption + "\"\n");
     }
 
     std::stringstream sBuffer;
@@ -407,8 +1441,7 @@ std::string Parser::getConverted(const std::string &option, const std::string& l
     if (rawValue.empty() && !(isSet(option) || isSet(longOption)))
         return defaultValue;
     else if (rawValue.empty()) {
-        std::cerr << "No value provided for \"" << option << "/" << longOption << "\"\n";
-        exit(0);
+        fail("No value provided for \"" + option + "/" + longOption + "\"\n");
     }
 
     return rawValue;
@@ -428,8 +1461,7 @@ std::vector<T> Parser::getMultiConverted(const std::string &option, const std::s
     if (rawValues.empty() && !(isSet(option) || isSet(longOption)))
         return defaultInit;
     else if (rawValues.empty()) {
-        std::cerr << "No value provided for \"" << option << "/" << longOption << "\"\n";
-        exit(0);
+        fail("No value provided for \"" + option + "/" + longOption + "\"\n");
     }
 
     std::stringstream sBuffer;
@@ -453,8 +1485,7 @@ std::vector<std::string> Parser::getMultiConverted(const std::string &option, co
     if (rawValues.empty() && !(isSet(option) || isSet(longOption)))
         return defaultInit;
     else if (rawValues.empty()) {
-        std::cerr << "No value provided for \"" << option << "/" << longOption << "\"\n";
-        exit(0);
+        fail("No value provided for \"" + option + "/" + longOption + "\"\n");
     }
 
     return rawValues;
@@ -581,7 +1612,87 @@ std::vector<bool> Parser::getMultiConverted(const unsigned int& pos, const unsig
     return values;
 }
 
+template<typename T>
+T Parser::convert(const std::string& rawValue) {
+    std::stringstream sBuffer;
+    T value;
+
+    sBuffer << rawValue;
+    sBuffer >> value;
+
+    return value;
+}
+
+template<>
+std::string Parser::convert(const std::string& rawValue) {
+    return rawValue;
+}
+
+template<>
+bool Parser::convert(const std::string& rawValue) {
+    std::stringstream sBuffer;
+    bool value;
+
+    sBuffer.setf(std::ios_base::boolalpha);
+
+    sBuffer << rawValue;
+    sBuffer >> value;
+
+    return value;
+}
+
+template<typename T, typename Func>
+size_t Parser::streamMultiConverted(const unsigned int& pos, const unsigned int& indent, Func callback, const size_t& batchSize, std::istream& input) {
+    std::vector<std::string>& tokens = activeTokens();
+
+    std::vector<T> batch;
+    batch.reserve(batchSize);
+    size_t delivered = 0;
+
+    auto flush = [&]() {
+        callback(static_cast<const std::vector<T>&>(batch));
+        delivered += batch.size();
+        batch.clear();
+    };
+
+    auto push = [&](const std::string& rawValue) {
+        batch.emplace_back(convert<T>(rawValue));
+        if (batch.size() >= batchSize)
+            flush();
+    };
+
+    for (size_t i = indent + pos; i < tokens.size(); ++i) {
+        if (!isStdinMarker(tokens[i])) {
+            push(tokens[i]);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(inputMutex);
+
+        std::string line;
+        while (true) {
+            //? getline would block, hand over what is there first
+            if (!batch.empty() && input.rdbuf()->in_avail() <= 0)
+                flush();
+            if (!std::getline(input, line))
+                break;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty())
+                push(line);
+        }
+    }
+
+    if (!batch.empty())
+        flush();
+
+    return delivered;
+}
+
 bool Parser::isSet(const std::string &option) {
+    std::vector<std::string>& tokens = activeTokens();
+
     return std::find(tokens.begin(), tokens.end(), option) != tokens.end();
 }
 
@@ -589,6 +1700,26 @@ bool Parser::hasOptionSyntax(const std::string& str) {
     return std::regex_match(str, std::regex("^(-{1,2}[a-zA-Z0-9_]{1,})"));
 }
 
+//? a pipeline segment must not end the process while other segments are running, so there it only fails the segment
+void Parser::fail(const std::string& message) {
+    std::cerr << message;
+
+    if (segmentTokens != nullptr)
+        throw ParserError(message);
+
+    exit(0);
+}
+
+std::vector<std::string>& Parser::activeTokens() {
+    return segmentTokens != nullptr ? *segmentTokens : tokens;
+}
+
+bool Parser::isStdinMarker(const std::string& str) {
+    return str == "-" || str == "--stdin";
+}
+
 std::vector<std::string> Parser::tokens;
+thread_local std::vector<std::string>* Parser::segmentTokens = nullptr;
+std::mutex Parser::inputMutex;
 
 #endif //CLIAPP_CLILIB_HPP
\ No newline at end of file